@@ -0,0 +1,163 @@
+/*****************************************************************************
+ * FILE NAME    : ChapterSchedule.c
+ * DATE         : October 19 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "ChapterSchedule.h"
+#include "GeneralUtilities/MemoryManager.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+#define CHAPTER_SCHEDULE_INFINITY       INT64_MAX
+
+/*****************************************************************************!
+ * Local Type : ChapterScheduleLayer
+ *  One day of the DP: current[j] is the lowest sum of squared daily loads
+ *  that reads chapters 0..j-1 in day + 1 days, previous[] is the same for
+ *  one day fewer, and opt[j] is where the last day starts.
+ *****************************************************************************/
+struct _ChapterScheduleLayer
+{
+  int64_t*                              prefix;
+  int64_t*                              previous;
+  int64_t*                              current;
+  int*                                  opt;
+};
+typedef struct _ChapterScheduleLayer ChapterScheduleLayer;
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static void
+ChapterScheduleSolve
+(ChapterScheduleLayer* InLayer, int InLow, int InHigh, int InOptLow, int InOptHigh);
+
+/*****************************************************************************!
+ * Function : ChapterScheduleCreate
+ *  Split InChapterCount chapters into InDays consecutive non-empty days so
+ *  that the variance of the daily verse count is as small as possible, and
+ *  write each day's verse count to OutDailyVerseCount.
+ *
+ *  With the total and the number of days fixed, minimising the variance is
+ *  minimising the sum of squared daily loads.  That cost satisfies the
+ *  quadrangle inequality, so the best split point for each day moves
+ *  monotonically with j and every DP layer can be solved by divide and
+ *  conquer in O(n log n), O(days * n log n) overall.
+ *
+ *  Returns false when there are more days than chapters.
+ *****************************************************************************/
+bool
+ChapterScheduleCreate
+(int* InChapterVerses, int InChapterCount, int InDays, int* OutDailyVerseCount)
+{
+  ChapterScheduleLayer                  layer;
+  int64_t*                              prefix;
+  int64_t*                              previous;
+  int64_t*                              current;
+  int64_t*                              t;
+  int*                                  opt;
+  int                                   n, i, j, k;
+
+  n = InChapterCount;
+  if ( NULL == InChapterVerses || NULL == OutDailyVerseCount || InDays <= 0 || InDays > n ) {
+    return false;
+  }
+
+  prefix = (int64_t*)GetMemory(sizeof(int64_t) * (n + 1));
+  previous = (int64_t*)GetMemory(sizeof(int64_t) * (n + 1));
+  current = (int64_t*)GetMemory(sizeof(int64_t) * (n + 1));
+  opt = (int*)GetMemory(sizeof(int) * (n + 1) * InDays);
+
+  prefix[0] = 0;
+  for ( i = 0; i < n; i++ ) {
+    prefix[i + 1] = prefix[i] + InChapterVerses[i];
+  }
+
+  //! A single day reads everything from the first chapter
+  for ( j = 0; j <= n; j++ ) {
+    current[j] = j > 0 ? prefix[j] * prefix[j] : CHAPTER_SCHEDULE_INFINITY;
+    opt[j] = 0;
+  }
+
+  layer.prefix = prefix;
+  for ( k = 1; k < InDays; k++ ) {
+    t = previous;
+    previous = current;
+    current = t;
+    for ( j = 0; j <= n; j++ ) {
+      current[j] = CHAPTER_SCHEDULE_INFINITY;
+    }
+    layer.previous = previous;
+    layer.current = current;
+    layer.opt = opt + (n + 1) * k;
+
+    //! Day k (0 based) must leave at least one chapter for each later day
+    ChapterScheduleSolve(&layer, k + 1, n - (InDays - 1 - k), k, n - (InDays - 1 - k) - 1);
+  }
+
+  j = n;
+  for ( k = InDays - 1; k >= 0; k-- ) {
+    i = opt[(n + 1) * k + j];
+    OutDailyVerseCount[k] = (int)(prefix[j] - prefix[i]);
+    j = i;
+  }
+
+  FreeMemory(prefix);
+  FreeMemory(previous);
+  FreeMemory(current);
+  FreeMemory(opt);
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : ChapterScheduleSolve
+ *  Fill current[InLow..InHigh], knowing the best split for each lies in
+ *  InOptLow..InOptHigh
+ *****************************************************************************/
+static void
+ChapterScheduleSolve
+(ChapterScheduleLayer* InLayer, int InLow, int InHigh, int InOptLow, int InOptHigh)
+{
+  int                                   mid, i, last, best;
+  int64_t                               cost, bestCost, load;
+
+  if ( InLow > InHigh ) {
+    return;
+  }
+
+  mid = (InLow + InHigh) / 2;
+  last = mid - 1 < InOptHigh ? mid - 1 : InOptHigh;
+  best = InOptLow;
+  bestCost = CHAPTER_SCHEDULE_INFINITY;
+  for ( i = InOptLow; i <= last; i++ ) {
+    if ( CHAPTER_SCHEDULE_INFINITY == InLayer->previous[i] ) {
+      continue;
+    }
+    load = InLayer->prefix[mid] - InLayer->prefix[i];
+    cost = InLayer->previous[i] + load * load;
+    if ( cost < bestCost ) {
+      bestCost = cost;
+      best = i;
+    }
+  }
+  InLayer->current[mid] = bestCost;
+  InLayer->opt[mid] = best;
+
+  ChapterScheduleSolve(InLayer, InLow, mid - 1, InOptLow, best);
+  ChapterScheduleSolve(InLayer, mid + 1, InHigh, best, InOptHigh);
+}
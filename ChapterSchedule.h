@@ -0,0 +1,22 @@
+/*****************************************************************************
+ * FILE NAME    : ChapterSchedule.h
+ * DATE         : October 19 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _chapterschedule_h_
+#define _chapterschedule_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdbool.h>
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+bool
+ChapterScheduleCreate
+(int* InChapterVerses, int InChapterCount, int InDays, int* OutDailyVerseCount);
+
+#endif /* _chapterschedule_h_ */
@@ -0,0 +1,1049 @@
+/*****************************************************************************
+ * FILE NAME    : OutputSink.c
+ * DATE         : October 19 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "OutputSink.h"
+#include "GeneralUtilities/MemoryManager.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+#define OUTPUT_BUFFER_INITIAL_SIZE      4096
+
+/*****************************************************************************!
+ * Local Type : OutputBuffer
+ *  A growable in-memory byte buffer used by sinks that cannot stream
+ *  straight to their file (EPUB needs every document before it can write
+ *  the archive directory).
+ *****************************************************************************/
+struct _OutputBuffer
+{
+  char*                                 data;
+  int                                   length;
+  int                                   size;
+};
+typedef struct _OutputBuffer OutputBuffer;
+
+/*****************************************************************************!
+ * Local Type : EpubItem
+ *****************************************************************************/
+struct _EpubItem
+{
+  string                                name;
+  string                                title;
+  OutputBuffer*                         contents;
+  uint32_t                              crc;
+  uint32_t                              offset;
+  struct _EpubItem*                     next;
+};
+typedef struct _EpubItem EpubItem;
+
+/*****************************************************************************!
+ * Local Type : EpubData
+ *****************************************************************************/
+struct _EpubData
+{
+  EpubItem*                             items;
+  EpubItem*                             lastItem;
+  int                                   itemCount;
+  OutputBuffer*                         section;
+  string                                sectionTitle;
+};
+typedef struct _EpubData EpubData;
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static OutputBuffer*
+OutputBufferCreate
+();
+
+static void
+OutputBufferDestroy
+(OutputBuffer* InBuffer);
+
+static void
+OutputBufferAppend
+(OutputBuffer* InBuffer, const char* InData, int InLength);
+
+static void
+OutputBufferPrintf
+(OutputBuffer* InBuffer, const char* InFormat, ...);
+
+static void
+OutputBufferAppendEscaped
+(OutputBuffer* InBuffer, string InText);
+
+static bool
+OutputSinkOpenFile
+(OutputSink* InSink);
+
+static bool
+HTMLSinkBegin
+(OutputSink* InSink);
+
+static void
+HTMLSinkBeginSection
+(OutputSink* InSink, string InTitle);
+
+static void
+HTMLSinkWriteVerse
+(OutputSink* InSink, string InBookName, int InChapter, int InVerse, string InText);
+
+static void
+HTMLSinkEndSection
+(OutputSink* InSink);
+
+static void
+HTMLSinkEnd
+(OutputSink* InSink);
+
+static bool
+TextSinkBegin
+(OutputSink* InSink);
+
+static void
+TextSinkBeginSection
+(OutputSink* InSink, string InTitle);
+
+static void
+TextSinkWriteVerse
+(OutputSink* InSink, string InBookName, int InChapter, int InVerse, string InText);
+
+static void
+TextSinkEndSection
+(OutputSink* InSink);
+
+static void
+TextSinkEnd
+(OutputSink* InSink);
+
+static bool
+EpubSinkBegin
+(OutputSink* InSink);
+
+static void
+EpubSinkBeginSection
+(OutputSink* InSink, string InTitle);
+
+static void
+EpubSinkWriteVerse
+(OutputSink* InSink, string InBookName, int InChapter, int InVerse, string InText);
+
+static void
+EpubSinkEndSection
+(OutputSink* InSink);
+
+static void
+EpubSinkEnd
+(OutputSink* InSink);
+
+static void
+EpubSinkDestroy
+(OutputSink* InSink);
+
+static void
+EpubDataDestroy
+(EpubData* InData);
+
+static EpubItem*
+EpubAddItem
+(EpubData* InData, string InName, string InTitle, OutputBuffer* InContents);
+
+static uint32_t
+Crc32
+(const char* InData, int InLength);
+
+static void
+ZipWrite16
+(FILE* InFile, uint16_t InValue);
+
+static void
+ZipWrite32
+(FILE* InFile, uint32_t InValue);
+
+/*****************************************************************************!
+ * Local Data
+ *****************************************************************************/
+static string
+EpubContainer =
+  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+  "<container version=\"1.0\" xmlns=\"urn:oasis:names:tc:opendocument:xmlns:container\">\n"
+  "  <rootfiles>\n"
+  "    <rootfile full-path=\"OEBPS/content.opf\" media-type=\"application/oebps-package+xml\"/>\n"
+  "  </rootfiles>\n"
+  "</container>\n";
+
+static string
+EpubStyle =
+  ".verse { font-weight : bold; padding-right : 0.5em; }\n"
+  "p { margin : 0.25em 0; }\n";
+
+/*****************************************************************************!
+ * Function : OutputSinkCreate
+ *  Create a sink for InFormat ("html", "text" or "epub") writing to
+ *  InBaseName plus the format's extension.  Returns NULL for an unknown
+ *  format.
+ *****************************************************************************/
+OutputSink*
+OutputSinkCreate
+(string InFormat, string InBaseName)
+{
+  OutputSink*                           sink;
+  string                                extension;
+
+  if ( NULL == InFormat || NULL == InBaseName ) {
+    return NULL;
+  }
+
+  sink = (OutputSink*)GetMemory(sizeof(OutputSink));
+  memset(sink, 0x00, sizeof(OutputSink));
+
+  if ( StringEqual(InFormat, "html") ) {
+    extension = ".html";
+    sink->Begin = HTMLSinkBegin;
+    sink->BeginSection = HTMLSinkBeginSection;
+    sink->WriteVerse = HTMLSinkWriteVerse;
+    sink->EndSection = HTMLSinkEndSection;
+    sink->End = HTMLSinkEnd;
+  } else if ( StringEqualsOneOf(InFormat, "txt", "text", NULL) ) {
+    extension = ".txt";
+    sink->Begin = TextSinkBegin;
+    sink->BeginSection = TextSinkBeginSection;
+    sink->WriteVerse = TextSinkWriteVerse;
+    sink->EndSection = TextSinkEndSection;
+    sink->End = TextSinkEnd;
+  } else if ( StringEqual(InFormat, "epub") ) {
+    extension = ".epub";
+    sink->Begin = EpubSinkBegin;
+    sink->BeginSection = EpubSinkBeginSection;
+    sink->WriteVerse = EpubSinkWriteVerse;
+    sink->EndSection = EpubSinkEndSection;
+    sink->End = EpubSinkEnd;
+    sink->Destroy = EpubSinkDestroy;
+  } else {
+    FreeMemory(sink);
+    return NULL;
+  }
+
+  sink->format = StringCopy(InFormat);
+  sink->fileName = (string)GetMemory(strlen(InBaseName) + strlen(extension) + 1);
+  sprintf(sink->fileName, "%s%s", InBaseName, extension);
+  return sink;
+}
+
+/*****************************************************************************!
+ * Function : OutputSinkDestroy
+ *****************************************************************************/
+void
+OutputSinkDestroy
+(OutputSink* InSink)
+{
+  if ( NULL == InSink ) {
+    return;
+  }
+  if ( InSink->file ) {
+    fclose(InSink->file);
+  }
+  if ( InSink->fileBuffer ) {
+    FreeMemory(InSink->fileBuffer);
+  }
+  if ( InSink->Destroy ) {
+    InSink->Destroy(InSink);
+  }
+  FreeMemory(InSink->format);
+  FreeMemory(InSink->fileName);
+  FreeMemory(InSink);
+}
+
+/*****************************************************************************!
+ * Function : OutputSinkListAppend
+ *****************************************************************************/
+OutputSink*
+OutputSinkListAppend
+(OutputSink* InList, OutputSink* InSink)
+{
+  OutputSink*                           sink;
+
+  if ( NULL == InList ) {
+    return InSink;
+  }
+  for ( sink = InList; sink->next; sink = sink->next ) {
+  }
+  sink->next = InSink;
+  return InList;
+}
+
+/*****************************************************************************!
+ * Function : OutputSinkListBegin
+ *  Begin every sink that has not been begun yet.  Called from
+ *  OutputSinkListBeginSection so no file is created until there is a
+ *  section with verses to write.
+ *****************************************************************************/
+bool
+OutputSinkListBegin
+(OutputSink* InList)
+{
+  OutputSink*                           sink;
+
+  if ( OutputSinkListFailed(InList) ) {
+    return false;
+  }
+  for ( sink = InList; sink; sink = sink->next ) {
+    if ( sink->begun ) {
+      continue;
+    }
+    if ( ! sink->Begin(sink) ) {
+      fprintf(stderr, "Error opening %s\n", sink->fileName);
+      sink->failed = true;
+      return false;
+    }
+    sink->begun = true;
+  }
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : OutputSinkListFailed
+ *  True once any sink in the list has failed to begin
+ *****************************************************************************/
+bool
+OutputSinkListFailed
+(OutputSink* InList)
+{
+  OutputSink*                           sink;
+
+  for ( sink = InList; sink; sink = sink->next ) {
+    if ( sink->failed ) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*****************************************************************************!
+ * Function : OutputSinkListBeginSection
+ *****************************************************************************/
+bool
+OutputSinkListBeginSection
+(OutputSink* InList, string InTitle)
+{
+  OutputSink*                           sink;
+
+  if ( ! OutputSinkListBegin(InList) ) {
+    return false;
+  }
+  for ( sink = InList; sink; sink = sink->next ) {
+    sink->BeginSection(sink, InTitle);
+  }
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : OutputSinkListWriteVerse
+ *****************************************************************************/
+void
+OutputSinkListWriteVerse
+(OutputSink* InList, string InBookName, int InChapter, int InVerse, string InText)
+{
+  OutputSink*                           sink;
+
+  for ( sink = InList; sink; sink = sink->next ) {
+    sink->WriteVerse(sink, InBookName, InChapter, InVerse, InText);
+  }
+}
+
+/*****************************************************************************!
+ * Function : OutputSinkListEndSection
+ *****************************************************************************/
+void
+OutputSinkListEndSection
+(OutputSink* InList)
+{
+  OutputSink*                           sink;
+
+  for ( sink = InList; sink; sink = sink->next ) {
+    sink->EndSection(sink);
+  }
+}
+
+/*****************************************************************************!
+ * Function : OutputSinkListEnd
+ *****************************************************************************/
+void
+OutputSinkListEnd
+(OutputSink* InList)
+{
+  OutputSink*                           sink;
+
+  for ( sink = InList; sink; sink = sink->next ) {
+    if ( ! sink->begun ) {
+      continue;
+    }
+    sink->End(sink);
+    sink->begun = false;
+    if ( sink->file ) {
+      fclose(sink->file);
+      sink->file = NULL;
+    }
+  }
+}
+
+/*****************************************************************************!
+ * Function : OutputSinkListAbort
+ *  Close and remove the files of every sink that has begun, so a failed
+ *  run leaves no partial output behind
+ *****************************************************************************/
+void
+OutputSinkListAbort
+(OutputSink* InList)
+{
+  OutputSink*                           sink;
+
+  for ( sink = InList; sink; sink = sink->next ) {
+    if ( ! sink->begun ) {
+      continue;
+    }
+    if ( sink->file ) {
+      fclose(sink->file);
+      sink->file = NULL;
+    }
+    remove(sink->fileName);
+    sink->begun = false;
+  }
+}
+
+/*****************************************************************************!
+ * Function : OutputSinkListDestroy
+ *****************************************************************************/
+void
+OutputSinkListDestroy
+(OutputSink* InList)
+{
+  OutputSink*                           sink;
+  OutputSink*                           next;
+
+  for ( sink = InList; sink; sink = next ) {
+    next = sink->next;
+    OutputSinkDestroy(sink);
+  }
+}
+
+/*****************************************************************************!
+ * Function : OutputSinkOpenFile
+ *  Open the sink's file with a private stdio buffer so each format batches
+ *  its own writes independently of the others.
+ *****************************************************************************/
+static bool
+OutputSinkOpenFile
+(OutputSink* InSink)
+{
+  InSink->file = fopen(InSink->fileName, "wb");
+  if ( NULL == InSink->file ) {
+    return false;
+  }
+  InSink->fileBuffer = (char*)GetMemory(OUTPUT_SINK_BUFFER_SIZE);
+  setvbuf(InSink->file, InSink->fileBuffer, _IOFBF, OUTPUT_SINK_BUFFER_SIZE);
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : HTMLSinkBegin
+ *****************************************************************************/
+static bool
+HTMLSinkBegin
+(OutputSink* InSink)
+{
+  if ( ! OutputSinkOpenFile(InSink) ) {
+    return false;
+  }
+  fprintf(InSink->file, "<HTML>\n");
+  fprintf(InSink->file, "<HEAD>\n");
+  fprintf(InSink->file, "  <LINK href=\"style.css\" type=\"text/css\" rel=\"stylesheet\"></LINK>\n");
+  fprintf(InSink->file, "</HEAD>\n");
+  fprintf(InSink->file, "<BODY>\n");
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : HTMLSinkBeginSection
+ *****************************************************************************/
+static void
+HTMLSinkBeginSection
+(OutputSink* InSink, string InTitle)
+{
+  fprintf(InSink->file, "  <A class=\"DateDisplay\">");
+  fprintf(InSink->file, "%s</A>\n", InTitle);
+  fprintf(InSink->file, "<TABLE>\n");
+}
+
+/*****************************************************************************!
+ * Function : HTMLSinkWriteVerse
+ *****************************************************************************/
+static void
+HTMLSinkWriteVerse
+(OutputSink* InSink, string InBookName, int InChapter, int InVerse, string InText)
+{
+  fprintf(InSink->file, "<tr>\n");
+  fprintf(InSink->file, "<td class=\"verse\">%s %d:%d</td>\n", InBookName, InChapter, InVerse);
+  fprintf(InSink->file, "<td class=\"text\">%s</td>\n", InText);
+  fprintf(InSink->file, "</tr>\n");
+}
+
+/*****************************************************************************!
+ * Function : HTMLSinkEndSection
+ *****************************************************************************/
+static void
+HTMLSinkEndSection
+(OutputSink* InSink)
+{
+  fprintf(InSink->file, "</TABLE>\n");
+}
+
+/*****************************************************************************!
+ * Function : HTMLSinkEnd
+ *****************************************************************************/
+static void
+HTMLSinkEnd
+(OutputSink* InSink)
+{
+  fprintf(InSink->file, "</BODY>\n");
+  fprintf(InSink->file, "</HTML>\n");
+}
+
+/*****************************************************************************!
+ * Function : TextSinkBegin
+ *****************************************************************************/
+static bool
+TextSinkBegin
+(OutputSink* InSink)
+{
+  return OutputSinkOpenFile(InSink);
+}
+
+/*****************************************************************************!
+ * Function : TextSinkBeginSection
+ *****************************************************************************/
+static void
+TextSinkBeginSection
+(OutputSink* InSink, string InTitle)
+{
+  fprintf(InSink->file, "%s\n\n", InTitle);
+}
+
+/*****************************************************************************!
+ * Function : TextSinkWriteVerse
+ *****************************************************************************/
+static void
+TextSinkWriteVerse
+(OutputSink* InSink, string InBookName, int InChapter, int InVerse, string InText)
+{
+  fprintf(InSink->file, "%s %d:%d %s\n", InBookName, InChapter, InVerse, InText);
+}
+
+/*****************************************************************************!
+ * Function : TextSinkEndSection
+ *****************************************************************************/
+static void
+TextSinkEndSection
+(OutputSink* InSink)
+{
+  fprintf(InSink->file, "\n");
+}
+
+/*****************************************************************************!
+ * Function : TextSinkEnd
+ *****************************************************************************/
+static void
+TextSinkEnd
+(OutputSink* InSink)
+{
+}
+
+/*****************************************************************************!
+ * Function : EpubSinkBegin
+ *  The archive is assembled in memory and written out in EpubSinkEnd, once
+ *  every section is known.
+ *****************************************************************************/
+static bool
+EpubSinkBegin
+(OutputSink* InSink)
+{
+  EpubData*                             data;
+
+  if ( ! OutputSinkOpenFile(InSink) ) {
+    return false;
+  }
+  data = (EpubData*)GetMemory(sizeof(EpubData));
+  memset(data, 0x00, sizeof(EpubData));
+  InSink->data = data;
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : EpubSinkBeginSection
+ *****************************************************************************/
+static void
+EpubSinkBeginSection
+(OutputSink* InSink, string InTitle)
+{
+  EpubData*                             data;
+  OutputBuffer*                         section;
+
+  data = (EpubData*)InSink->data;
+  section = OutputBufferCreate();
+  data->section = section;
+  data->sectionTitle = StringCopy(InTitle);
+
+  OutputBufferPrintf(section,
+                     "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                     "<!DOCTYPE html>\n"
+                     "<html xmlns=\"http://www.w3.org/1999/xhtml\">\n"
+                     "<head>\n"
+                     "  <title>");
+  OutputBufferAppendEscaped(section, InTitle);
+  OutputBufferPrintf(section,
+                     "</title>\n"
+                     "  <link href=\"style.css\" type=\"text/css\" rel=\"stylesheet\"/>\n"
+                     "</head>\n"
+                     "<body>\n"
+                     "  <h2>");
+  OutputBufferAppendEscaped(section, InTitle);
+  OutputBufferPrintf(section, "</h2>\n");
+}
+
+/*****************************************************************************!
+ * Function : EpubSinkWriteVerse
+ *****************************************************************************/
+static void
+EpubSinkWriteVerse
+(OutputSink* InSink, string InBookName, int InChapter, int InVerse, string InText)
+{
+  OutputBuffer*                         section;
+
+  section = ((EpubData*)InSink->data)->section;
+  OutputBufferPrintf(section, "  <p><span class=\"verse\">");
+  OutputBufferAppendEscaped(section, InBookName);
+  OutputBufferPrintf(section, " %d:%d</span> ", InChapter, InVerse);
+  OutputBufferAppendEscaped(section, InText);
+  OutputBufferPrintf(section, "</p>\n");
+}
+
+/*****************************************************************************!
+ * Function : EpubSinkEndSection
+ *****************************************************************************/
+static void
+EpubSinkEndSection
+(OutputSink* InSink)
+{
+  EpubData*                             data;
+  char                                  name[32];
+
+  data = (EpubData*)InSink->data;
+  OutputBufferPrintf(data->section, "</body>\n</html>\n");
+  sprintf(name, "OEBPS/section%04d.xhtml", data->itemCount + 1);
+  EpubAddItem(data, name, data->sectionTitle, data->section);
+  FreeMemory(data->sectionTitle);
+  data->sectionTitle = NULL;
+  data->section = NULL;
+}
+
+/*****************************************************************************!
+ * Function : EpubSinkEnd
+ *  Write the stored (uncompressed) zip container.  The mimetype entry must
+ *  be first, which is why the fixed entries are placed ahead of the
+ *  sections collected so far.
+ *****************************************************************************/
+static void
+EpubSinkEnd
+(OutputSink* InSink)
+{
+  EpubData*                             data;
+  EpubItem*                             sections;
+  EpubItem*                             item;
+  OutputBuffer*                         buffer;
+  FILE*                                 file;
+  uint32_t                              directoryStart, directorySize;
+  uint16_t                              dosTime, dosDate;
+  int                                   n, sectionCount;
+  time_t                                now;
+  struct tm*                            t;
+  char                                  modified[32];
+
+  data = (EpubData*)InSink->data;
+  file = InSink->file;
+  sections = data->items;
+  sectionCount = data->itemCount;
+  data->items = NULL;
+  data->lastItem = NULL;
+
+  now = time(NULL);
+  t = gmtime(&now);
+  strftime(modified, sizeof(modified), "%Y-%m-%dT%H:%M:%SZ", t);
+  dosTime = (uint16_t)((t->tm_hour << 11) | (t->tm_min << 5) | (t->tm_sec / 2));
+  dosDate = (uint16_t)(((t->tm_year - 80) << 9) | ((t->tm_mon + 1) << 5) | t->tm_mday);
+
+  buffer = OutputBufferCreate();
+  OutputBufferPrintf(buffer, "application/epub+zip");
+  EpubAddItem(data, "mimetype", NULL, buffer);
+
+  buffer = OutputBufferCreate();
+  OutputBufferPrintf(buffer, "%s", EpubContainer);
+  EpubAddItem(data, "META-INF/container.xml", NULL, buffer);
+
+  buffer = OutputBufferCreate();
+  OutputBufferPrintf(buffer, "%s", EpubStyle);
+  EpubAddItem(data, "OEBPS/style.css", NULL, buffer);
+
+  buffer = OutputBufferCreate();
+  OutputBufferPrintf(buffer,
+                     "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                     "<package xmlns=\"http://www.idpf.org/2007/opf\" version=\"3.0\" unique-identifier=\"uid\">\n"
+                     "  <metadata xmlns:dc=\"http://purl.org/dc/elements/1.1/\">\n"
+                     "    <dc:identifier id=\"uid\">urn:bible-reading:%s</dc:identifier>\n"
+                     "    <dc:title>Bible Reading</dc:title>\n"
+                     "    <dc:language>en</dc:language>\n"
+                     "    <meta property=\"dcterms:modified\">%s</meta>\n"
+                     "  </metadata>\n"
+                     "  <manifest>\n"
+                     "    <item id=\"nav\" href=\"nav.xhtml\" media-type=\"application/xhtml+xml\" properties=\"nav\"/>\n"
+                     "    <item id=\"style\" href=\"style.css\" media-type=\"text/css\"/>\n",
+                     modified, modified);
+  for ( item = sections, n = 1; item; item = item->next, n++ ) {
+    OutputBufferPrintf(buffer,
+                       "    <item id=\"section%04d\" href=\"%s\" media-type=\"application/xhtml+xml\"/>\n",
+                       n, item->name + strlen("OEBPS/"));
+  }
+  OutputBufferPrintf(buffer, "  </manifest>\n  <spine>\n");
+  for ( n = 1; n <= sectionCount; n++ ) {
+    OutputBufferPrintf(buffer, "    <itemref idref=\"section%04d\"/>\n", n);
+  }
+  OutputBufferPrintf(buffer, "  </spine>\n</package>\n");
+  EpubAddItem(data, "OEBPS/content.opf", NULL, buffer);
+
+  buffer = OutputBufferCreate();
+  OutputBufferPrintf(buffer,
+                     "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                     "<!DOCTYPE html>\n"
+                     "<html xmlns=\"http://www.w3.org/1999/xhtml\" xmlns:epub=\"http://www.idpf.org/2007/ops\">\n"
+                     "<head>\n  <title>Contents</title>\n</head>\n"
+                     "<body>\n"
+                     "  <nav epub:type=\"toc\">\n"
+                     "    <ol>\n");
+  for ( item = sections; item; item = item->next ) {
+    OutputBufferPrintf(buffer, "      <li><a href=\"%s\">", item->name + strlen("OEBPS/"));
+    OutputBufferAppendEscaped(buffer, item->title);
+    OutputBufferPrintf(buffer, "</a></li>\n");
+  }
+  OutputBufferPrintf(buffer, "    </ol>\n  </nav>\n</body>\n</html>\n");
+  EpubAddItem(data, "OEBPS/nav.xhtml", NULL, buffer);
+
+  //! Fixed entries first, then the sections
+  if ( data->lastItem ) {
+    data->lastItem->next = sections;
+  } else {
+    data->items = sections;
+  }
+
+  for ( item = data->items; item; item = item->next ) {
+    item->crc = Crc32(item->contents->data, item->contents->length);
+    item->offset = (uint32_t)ftell(file);
+    ZipWrite32(file, 0x04034B50);
+    ZipWrite16(file, 10);
+    ZipWrite16(file, 0);
+    ZipWrite16(file, 0);
+    ZipWrite16(file, dosTime);
+    ZipWrite16(file, dosDate);
+    ZipWrite32(file, item->crc);
+    ZipWrite32(file, item->contents->length);
+    ZipWrite32(file, item->contents->length);
+    ZipWrite16(file, strlen(item->name));
+    ZipWrite16(file, 0);
+    fwrite(item->name, 1, strlen(item->name), file);
+    fwrite(item->contents->data, 1, item->contents->length, file);
+  }
+
+  directoryStart = (uint32_t)ftell(file);
+  n = 0;
+  for ( item = data->items; item; item = item->next ) {
+    ZipWrite32(file, 0x02014B50);
+    ZipWrite16(file, 20);
+    ZipWrite16(file, 10);
+    ZipWrite16(file, 0);
+    ZipWrite16(file, 0);
+    ZipWrite16(file, dosTime);
+    ZipWrite16(file, dosDate);
+    ZipWrite32(file, item->crc);
+    ZipWrite32(file, item->contents->length);
+    ZipWrite32(file, item->contents->length);
+    ZipWrite16(file, strlen(item->name));
+    ZipWrite16(file, 0);
+    ZipWrite16(file, 0);
+    ZipWrite16(file, 0);
+    ZipWrite16(file, 0);
+    ZipWrite32(file, 0);
+    ZipWrite32(file, item->offset);
+    fwrite(item->name, 1, strlen(item->name), file);
+    n++;
+  }
+  directorySize = (uint32_t)ftell(file) - directoryStart;
+
+  ZipWrite32(file, 0x06054B50);
+  ZipWrite16(file, 0);
+  ZipWrite16(file, 0);
+  ZipWrite16(file, n);
+  ZipWrite16(file, n);
+  ZipWrite32(file, directorySize);
+  ZipWrite32(file, directoryStart);
+  ZipWrite16(file, 0);
+}
+
+/*****************************************************************************!
+ * Function : EpubSinkDestroy
+ *****************************************************************************/
+static void
+EpubSinkDestroy
+(OutputSink* InSink)
+{
+  if ( InSink->data ) {
+    EpubDataDestroy((EpubData*)InSink->data);
+    InSink->data = NULL;
+  }
+}
+
+/*****************************************************************************!
+ * Function : EpubDataDestroy
+ *****************************************************************************/
+static void
+EpubDataDestroy
+(EpubData* InData)
+{
+  EpubItem*                             item;
+  EpubItem*                             next;
+
+  for ( item = InData->items; item; item = next ) {
+    next = item->next;
+    FreeMemory(item->name);
+    if ( item->title ) {
+      FreeMemory(item->title);
+    }
+    OutputBufferDestroy(item->contents);
+    FreeMemory(item);
+  }
+  if ( InData->section ) {
+    OutputBufferDestroy(InData->section);
+  }
+  if ( InData->sectionTitle ) {
+    FreeMemory(InData->sectionTitle);
+  }
+  FreeMemory(InData);
+}
+
+/*****************************************************************************!
+ * Function : EpubAddItem
+ *****************************************************************************/
+static EpubItem*
+EpubAddItem
+(EpubData* InData, string InName, string InTitle, OutputBuffer* InContents)
+{
+  EpubItem*                             item;
+
+  item = (EpubItem*)GetMemory(sizeof(EpubItem));
+  item->name = StringCopy(InName);
+  item->title = InTitle ? StringCopy(InTitle) : NULL;
+  item->contents = InContents;
+  item->crc = 0;
+  item->offset = 0;
+  item->next = NULL;
+
+  if ( InData->lastItem ) {
+    InData->lastItem->next = item;
+  } else {
+    InData->items = item;
+  }
+  InData->lastItem = item;
+  InData->itemCount++;
+  return item;
+}
+
+/*****************************************************************************!
+ * Function : Crc32
+ *****************************************************************************/
+static uint32_t
+Crc32
+(const char* InData, int InLength)
+{
+  static uint32_t                       table[256];
+  static bool                           tableBuilt = false;
+  uint32_t                              c;
+  int                                   i, j;
+
+  if ( ! tableBuilt ) {
+    for ( i = 0; i < 256; i++ ) {
+      c = (uint32_t)i;
+      for ( j = 0; j < 8; j++ ) {
+        c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+      }
+      table[i] = c;
+    }
+    tableBuilt = true;
+  }
+
+  c = 0xFFFFFFFF;
+  for ( i = 0; i < InLength; i++ ) {
+    c = table[(c ^ (uint8_t)InData[i]) & 0xFF] ^ (c >> 8);
+  }
+  return c ^ 0xFFFFFFFF;
+}
+
+/*****************************************************************************!
+ * Function : ZipWrite16
+ *****************************************************************************/
+static void
+ZipWrite16
+(FILE* InFile, uint16_t InValue)
+{
+  fputc(InValue & 0xFF, InFile);
+  fputc((InValue >> 8) & 0xFF, InFile);
+}
+
+/*****************************************************************************!
+ * Function : ZipWrite32
+ *****************************************************************************/
+static void
+ZipWrite32
+(FILE* InFile, uint32_t InValue)
+{
+  ZipWrite16(InFile, (uint16_t)(InValue & 0xFFFF));
+  ZipWrite16(InFile, (uint16_t)((InValue >> 16) & 0xFFFF));
+}
+
+/*****************************************************************************!
+ * Function : OutputBufferCreate
+ *****************************************************************************/
+static OutputBuffer*
+OutputBufferCreate
+()
+{
+  OutputBuffer*                         buffer;
+
+  buffer = (OutputBuffer*)GetMemory(sizeof(OutputBuffer));
+  buffer->size = OUTPUT_BUFFER_INITIAL_SIZE;
+  buffer->length = 0;
+  buffer->data = (char*)GetMemory(buffer->size);
+  buffer->data[0] = 0x00;
+  return buffer;
+}
+
+/*****************************************************************************!
+ * Function : OutputBufferDestroy
+ *****************************************************************************/
+static void
+OutputBufferDestroy
+(OutputBuffer* InBuffer)
+{
+  if ( NULL == InBuffer ) {
+    return;
+  }
+  FreeMemory(InBuffer->data);
+  FreeMemory(InBuffer);
+}
+
+/*****************************************************************************!
+ * Function : OutputBufferAppend
+ *****************************************************************************/
+static void
+OutputBufferAppend
+(OutputBuffer* InBuffer, const char* InData, int InLength)
+{
+  char*                                 data;
+  int                                   size;
+
+  if ( InBuffer->length + InLength + 1 > InBuffer->size ) {
+    size = InBuffer->size;
+    while ( InBuffer->length + InLength + 1 > size ) {
+      size *= 2;
+    }
+    data = (char*)GetMemory(size);
+    memcpy(data, InBuffer->data, InBuffer->length);
+    FreeMemory(InBuffer->data);
+    InBuffer->data = data;
+    InBuffer->size = size;
+  }
+  memcpy(InBuffer->data + InBuffer->length, InData, InLength);
+  InBuffer->length += InLength;
+  InBuffer->data[InBuffer->length] = 0x00;
+}
+
+/*****************************************************************************!
+ * Function : OutputBufferPrintf
+ *****************************************************************************/
+static void
+OutputBufferPrintf
+(OutputBuffer* InBuffer, const char* InFormat, ...)
+{
+  va_list                               args;
+  int                                   n;
+  char*                                 s;
+
+  va_start(args, InFormat);
+  n = vsnprintf(NULL, 0, InFormat, args);
+  va_end(args);
+
+  s = (char*)GetMemory(n + 1);
+  va_start(args, InFormat);
+  vsnprintf(s, n + 1, InFormat, args);
+  va_end(args);
+
+  OutputBufferAppend(InBuffer, s, n);
+  FreeMemory(s);
+}
+
+/*****************************************************************************!
+ * Function : OutputBufferAppendEscaped
+ *  Append InText with the XML special characters escaped
+ *****************************************************************************/
+static void
+OutputBufferAppendEscaped
+(OutputBuffer* InBuffer, string InText)
+{
+  string                                s;
+  string                                start;
+
+  if ( NULL == InText ) {
+    return;
+  }
+  start = InText;
+  for ( s = InText; *s; s++ ) {
+    if ( *s != '&' && *s != '<' && *s != '>' ) {
+      continue;
+    }
+    OutputBufferAppend(InBuffer, start, s - start);
+    if ( *s == '&' ) {
+      OutputBufferAppend(InBuffer, "&amp;", 5);
+    } else if ( *s == '<' ) {
+      OutputBufferAppend(InBuffer, "&lt;", 4);
+    } else {
+      OutputBufferAppend(InBuffer, "&gt;", 4);
+    }
+    start = s + 1;
+  }
+  OutputBufferAppend(InBuffer, start, s - start);
+}
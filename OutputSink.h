@@ -0,0 +1,108 @@
+/*****************************************************************************
+ * FILE NAME    : OutputSink.h
+ * DATE         : October 19 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _outputsink_h_
+#define _outputsink_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "GeneralUtilities/StringUtil.h"
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+#define OUTPUT_SINK_BUFFER_SIZE         (64 * 1024)
+
+/*****************************************************************************!
+ * Exported Type : OutputSink
+ *  One output format.  The verse stream is fanned out to every sink in a
+ *  list, so a single pass over the database rows writes every format.
+ *****************************************************************************/
+struct _OutputSink;
+typedef struct _OutputSink OutputSink;
+
+struct _OutputSink
+{
+  string                                format;
+  string                                fileName;
+  FILE*                                 file;
+  char*                                 fileBuffer;
+  void*                                 data;
+  bool                                  begun;
+  bool                                  failed;
+
+  bool                                  (*Begin)
+                                        (OutputSink* InSink);
+  void                                  (*BeginSection)
+                                        (OutputSink* InSink, string InTitle);
+  void                                  (*WriteVerse)
+                                        (OutputSink* InSink, string InBookName, int InChapter, int InVerse, string InText);
+  void                                  (*EndSection)
+                                        (OutputSink* InSink);
+  void                                  (*End)
+                                        (OutputSink* InSink);
+  void                                  (*Destroy)
+                                        (OutputSink* InSink);
+
+  OutputSink*                           next;
+};
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+OutputSink*
+OutputSinkCreate
+(string InFormat, string InBaseName);
+
+void
+OutputSinkDestroy
+(OutputSink* InSink);
+
+OutputSink*
+OutputSinkListAppend
+(OutputSink* InList, OutputSink* InSink);
+
+bool
+OutputSinkListBegin
+(OutputSink* InList);
+
+bool
+OutputSinkListFailed
+(OutputSink* InList);
+
+bool
+OutputSinkListBeginSection
+(OutputSink* InList, string InTitle);
+
+void
+OutputSinkListWriteVerse
+(OutputSink* InList, string InBookName, int InChapter, int InVerse, string InText);
+
+void
+OutputSinkListEndSection
+(OutputSink* InList);
+
+void
+OutputSinkListEnd
+(OutputSink* InList);
+
+void
+OutputSinkListAbort
+(OutputSink* InList);
+
+void
+OutputSinkListDestroy
+(OutputSink* InList);
+
+#endif /* _outputsink_h_ */
@@ -0,0 +1,646 @@
+/*****************************************************************************
+ * FILE NAME    : ScriptureReference.c
+ * DATE         : October 19 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "ScriptureReference.h"
+#include "GeneralUtilities/MemoryManager.h"
+
+/*****************************************************************************!
+ * Local Macros
+ *****************************************************************************/
+#define BOOK_INDEX_NODE_CHILDREN        36
+#define BOOK_INDEX_INITIAL_NODES        1024
+#define BOOK_INDEX_AMBIGUOUS            -1
+
+/*****************************************************************************!
+ * Local Type : BookIndexNode
+ *  prefixBook is the only book whose full name passes through this node,
+ *  or BOOK_INDEX_AMBIGUOUS when several do.  exactBook is set where a full
+ *  name or alias ends, and takes precedence over prefixBook.
+ *****************************************************************************/
+struct _BookIndexNode
+{
+  int                                   children[BOOK_INDEX_NODE_CHILDREN];
+  int                                   prefixBook;
+  int                                   exactBook;
+};
+typedef struct _BookIndexNode BookIndexNode;
+
+/*****************************************************************************!
+ * Local Type : BookAlias
+ *****************************************************************************/
+struct _BookAlias
+{
+  string                                alias;
+  string                                bookName;
+};
+typedef struct _BookAlias BookAlias;
+
+/*****************************************************************************!
+ * Local Functions
+ *****************************************************************************/
+static int
+BookIndexNodeCreate
+(BookIndex* InIndex);
+
+static int
+BookIndexCharIndex
+(char InChar);
+
+static int
+BookIndexInsert
+(BookIndex* InIndex, string InName, int InBook, bool InPrefix);
+
+static bool
+ReferenceIsBookStart
+(string InPosition);
+
+static bool
+ReferenceIsDash
+(string InPosition, int* OutLength);
+
+static int
+ReferenceParseNumber
+(string* InOutPosition);
+
+static string
+ReferenceSkipSpaces
+(string InPosition);
+
+/*****************************************************************************!
+ * Local Data
+ *  Common abbreviations that are not simply a prefix of the book's name,
+ *  or that would otherwise be ambiguous
+ *****************************************************************************/
+static BookAlias
+BookStandardAliases[] =
+{
+  { "Gn",       "Genesis" },
+  { "Lv",       "Leviticus" },
+  { "Nm",       "Numbers" },
+  { "Dt",       "Deuteronomy" },
+  { "Jg",       "Judges" },
+  { "Jdg",      "Judges" },
+  { "Jdgs",     "Judges" },
+  { "Rth",      "Ruth" },
+  { "1 Sm",     "1 Samuel" },
+  { "2 Sm",     "2 Samuel" },
+  { "1 Kgs",    "1 Kings" },
+  { "2 Kgs",    "2 Kings" },
+  { "Jb",       "Job" },
+  { "Pss",      "Psalms" },
+  { "Prv",      "Proverbs" },
+  { "Qoh",      "Ecclesiastes" },
+  { "Sg",       "Song of Solomon" },
+  { "SoS",      "Song of Solomon" },
+  { "Song of Songs", "Song of Solomon" },
+  { "Ezk",      "Ezekiel" },
+  { "Dn",       "Daniel" },
+  { "Jl",       "Joel" },
+  { "Jnh",      "Jonah" },
+  { "Hb",       "Habakkuk" },
+  { "Hg",       "Haggai" },
+  { "Mt",       "Matthew" },
+  { "Mk",       "Mark" },
+  { "Mrk",      "Mark" },
+  { "Lk",       "Luke" },
+  { "Jn",       "John" },
+  { "Jhn",      "John" },
+  { "Rm",       "Romans" },
+  { "Phil",     "Philippians" },
+  { "Php",      "Philippians" },
+  { "Phlm",     "Philemon" },
+  { "Phm",      "Philemon" },
+  { "1 Tm",     "1 Timothy" },
+  { "2 Tm",     "2 Timothy" },
+  { "Jas",      "James" },
+  { "Jm",       "James" },
+  { "1 Pt",     "1 Peter" },
+  { "2 Pt",     "2 Peter" },
+  { "1 Jn",     "1 John" },
+  { "2 Jn",     "2 John" },
+  { "3 Jn",     "3 John" },
+  { "Rv",       "Revelation" },
+  { NULL,       NULL }
+};
+
+/*****************************************************************************!
+ * Function : BookIndexCreate
+ *****************************************************************************/
+BookIndex*
+BookIndexCreate
+()
+{
+  BookIndex*                            index;
+
+  index = (BookIndex*)GetMemory(sizeof(BookIndex));
+  memset(index, 0x00, sizeof(BookIndex));
+  index->nodeSize = BOOK_INDEX_INITIAL_NODES;
+  index->nodes = (BookIndexNode*)GetMemory(sizeof(BookIndexNode) * index->nodeSize);
+
+  //! Node 0 is the root
+  BookIndexNodeCreate(index);
+  return index;
+}
+
+/*****************************************************************************!
+ * Function : BookIndexDestroy
+ *****************************************************************************/
+void
+BookIndexDestroy
+(BookIndex* InIndex)
+{
+  int                                   i;
+
+  if ( NULL == InIndex ) {
+    return;
+  }
+  for ( i = 0; i < BOOK_INDEX_MAX_BOOKS; i++ ) {
+    if ( InIndex->bookNames[i] ) {
+      FreeMemory(InIndex->bookNames[i]);
+    }
+  }
+  FreeMemory(InIndex->nodes);
+  FreeMemory(InIndex);
+}
+
+/*****************************************************************************!
+ * Function : BookIndexAddBook
+ *  Add a book's full name; every prefix of the name is also indexed
+ *****************************************************************************/
+bool
+BookIndexAddBook
+(BookIndex* InIndex, string InName, int InBook, int InChapterCount)
+{
+  if ( NULL == InIndex || NULL == InName || InBook <= 0 || InBook >= BOOK_INDEX_MAX_BOOKS ) {
+    return false;
+  }
+  if ( BookIndexInsert(InIndex, InName, InBook, true) < 0 ) {
+    return false;
+  }
+  if ( InIndex->bookNames[InBook] ) {
+    FreeMemory(InIndex->bookNames[InBook]);
+  }
+  InIndex->bookNames[InBook] = StringCopy(InName);
+  InIndex->chapterCounts[InBook] = InChapterCount;
+  return true;
+}
+
+/*****************************************************************************!
+ * Function : BookIndexAddAlias
+ *  Add an alias that only matches in full
+ *****************************************************************************/
+bool
+BookIndexAddAlias
+(BookIndex* InIndex, string InAlias, int InBook)
+{
+  if ( NULL == InIndex || NULL == InAlias || InBook <= 0 || InBook >= BOOK_INDEX_MAX_BOOKS ) {
+    return false;
+  }
+  return BookIndexInsert(InIndex, InAlias, InBook, false) >= 0;
+}
+
+/*****************************************************************************!
+ * Function : BookIndexAddStandardAliases
+ *  Add the standard abbreviations for every book already in the index
+ *****************************************************************************/
+void
+BookIndexAddStandardAliases
+(BookIndex* InIndex)
+{
+  BookAlias*                            alias;
+  int                                   book;
+
+  for ( alias = BookStandardAliases; alias->alias; alias++ ) {
+    book = BookIndexLookup(InIndex, alias->bookName, strlen(alias->bookName));
+    if ( book > 0 ) {
+      BookIndexAddAlias(InIndex, alias->alias, book);
+    }
+  }
+}
+
+/*****************************************************************************!
+ * Function : BookIndexLookup
+ *  Return the book named by the first InLength characters of InName, or
+ *  -1 if it is unknown or ambiguous.  Case, spaces and periods are ignored.
+ *****************************************************************************/
+int
+BookIndexLookup
+(BookIndex* InIndex, string InName, int InLength)
+{
+  int                                   i, c, node;
+  BookIndexNode*                        n;
+
+  if ( NULL == InIndex || NULL == InName ) {
+    return -1;
+  }
+
+  node = 0;
+  for ( i = 0; i < InLength && InName[i]; i++ ) {
+    c = BookIndexCharIndex(InName[i]);
+    if ( c < 0 ) {
+      continue;
+    }
+    node = InIndex->nodes[node].children[c];
+    if ( 0 == node ) {
+      return -1;
+    }
+  }
+  if ( 0 == node ) {
+    return -1;
+  }
+
+  n = &InIndex->nodes[node];
+  if ( n->exactBook > 0 ) {
+    return n->exactBook;
+  }
+  if ( n->prefixBook > 0 ) {
+    return n->prefixBook;
+  }
+  return -1;
+}
+
+/*****************************************************************************!
+ * Function : ScriptureReferenceParse
+ *  Parse a reference list such as "Gen 1:1-3; Ps 23; Rom 8" into
+ *  OutRanges.  A piece without a book continues the previous book; after
+ *  a ',' a bare number is a verse of the previous chapter.  A piece with
+ *  neither a book nor a number ("Ps 23;;") is an error.  Returns the
+ *  number of ranges, SCRIPTURE_REFERENCE_INVALID if the reference cannot
+ *  be parsed or names a chapter the book does not have, or
+ *  SCRIPTURE_REFERENCE_TOO_MANY if it has more than InMaxRanges ranges.
+ *****************************************************************************/
+int
+ScriptureReferenceParse
+(BookIndex* InIndex, string InReference, ScriptureRange* OutRanges, int InMaxRanges)
+{
+  string                                p;
+  string                                nameStart;
+  int                                   count, book, chapter, dashLength;
+  int                                   n1, n2, n3, n4;
+  int                                   sc, sv, ec, ev, lastChapter;
+  bool                                  verseContext, hasColon, seenLetter, namedBook;
+  ScriptureRange*                       range;
+
+  if ( NULL == InIndex || NULL == InReference || NULL == OutRanges ) {
+    return SCRIPTURE_REFERENCE_INVALID;
+  }
+
+  count = 0;
+  book = 0;
+  chapter = 0;
+  verseContext = false;
+  p = InReference;
+
+  while ( true ) {
+    p = ReferenceSkipSpaces(p);
+    if ( *p == 0x00 ) {
+      break;
+    }
+
+    //! An optional book name: digits, then letters, spaces and periods
+    namedBook = false;
+    if ( ReferenceIsBookStart(p) ) {
+      nameStart = p;
+      seenLetter = false;
+      while ( *p && (isalnum((unsigned char)*p) || *p == ' ' || *p == '.') ) {
+        if ( isdigit((unsigned char)*p) && seenLetter ) {
+          break;
+        }
+        if ( isalpha((unsigned char)*p) ) {
+          seenLetter = true;
+        }
+        p++;
+      }
+      book = BookIndexLookup(InIndex, nameStart, p - nameStart);
+      if ( book <= 0 ) {
+        return SCRIPTURE_REFERENCE_INVALID;
+      }
+      chapter = 0;
+      verseContext = false;
+      namedBook = true;
+      p = ReferenceSkipSpaces(p);
+    }
+    if ( book <= 0 ) {
+      return SCRIPTURE_REFERENCE_INVALID;
+    }
+
+    n1 = n2 = n3 = n4 = 0;
+    hasColon = false;
+    if ( isdigit((unsigned char)*p) ) {
+      n1 = ReferenceParseNumber(&p);
+      if ( *p == ':' ) {
+        p++;
+        hasColon = true;
+        n2 = ReferenceParseNumber(&p);
+      }
+      p = ReferenceSkipSpaces(p);
+      if ( ReferenceIsDash(p, &dashLength) ) {
+        p = ReferenceSkipSpaces(p + dashLength);
+        n3 = ReferenceParseNumber(&p);
+        if ( *p == ':' ) {
+          p++;
+          n4 = ReferenceParseNumber(&p);
+        }
+      }
+    }
+    if ( n1 < 0 || n2 < 0 || n3 < 0 || n4 < 0 ) {
+      return SCRIPTURE_REFERENCE_INVALID;
+    }
+
+    //! A single chapter book is cited by verse alone ("Jude 3")
+    if ( n1 && ! hasColon && ! verseContext && 1 == InIndex->chapterCounts[book] ) {
+      chapter = 1;
+      verseContext = true;
+    }
+
+    //! Chapters are checked against the book when its size is known
+    lastChapter = InIndex->chapterCounts[book] > 0 ? InIndex->chapterCounts[book] : SCRIPTURE_LAST_CHAPTER;
+
+    if ( 0 == n1 ) {
+      //! Only a piece that names a book may stand for the whole book
+      if ( ! namedBook ) {
+        return SCRIPTURE_REFERENCE_INVALID;
+      }
+      sc = 1;
+      sv = 1;
+      ec = lastChapter;
+      ev = SCRIPTURE_LAST_VERSE;
+    } else if ( verseContext && ! hasColon ) {
+      sc = chapter;
+      sv = n1;
+      ec = n4 ? n3 : chapter;
+      ev = n4 ? n4 : (n3 ? n3 : n1);
+    } else if ( hasColon ) {
+      sc = n1;
+      sv = n2;
+      ec = n4 ? n3 : n1;
+      ev = n4 ? n4 : (n3 ? n3 : n2);
+    } else {
+      sc = n1;
+      sv = 1;
+      ec = n3 ? n3 : n1;
+      ev = n4 ? n4 : SCRIPTURE_LAST_VERSE;
+    }
+
+    if ( sc <= 0 || sv <= 0 || ec <= 0 || ev <= 0 ||
+         sc > lastChapter || ec > lastChapter ||
+         sv > SCRIPTURE_LAST_VERSE || ev > SCRIPTURE_LAST_VERSE ||
+         sc * 1000 + sv > ec * 1000 + ev ) {
+      return SCRIPTURE_REFERENCE_INVALID;
+    }
+
+    if ( count >= InMaxRanges ) {
+      return SCRIPTURE_REFERENCE_TOO_MANY;
+    }
+    range = &OutRanges[count++];
+    range->book = book;
+    range->startChapter = sc;
+    range->startVerse = sv;
+    range->endChapter = ec;
+    range->endVerse = ev;
+    range->startID = book * 1000000 + sc * 1000 + sv;
+    range->endID = book * 1000000 + ec * 1000 + ev;
+
+    chapter = ec;
+    p = ReferenceSkipSpaces(p);
+    if ( *p == ',' ) {
+      verseContext = (ev != SCRIPTURE_LAST_VERSE);
+      p++;
+    } else if ( *p == ';' ) {
+      verseContext = false;
+      p++;
+    } else if ( *p != 0x00 ) {
+      return SCRIPTURE_REFERENCE_INVALID;
+    }
+  }
+  return count;
+}
+
+/*****************************************************************************!
+ * Function : ScriptureRangeFormat
+ *  Format InRange in its shortest conventional form
+ *****************************************************************************/
+void
+ScriptureRangeFormat
+(BookIndex* InIndex, ScriptureRange* InRange, string OutBuffer, int InBufferSize)
+{
+  string                                name = NULL;
+  int                                   sc, sv, ec, ev;
+
+  if ( InRange->book <= 0 || InRange->book >= BOOK_INDEX_MAX_BOOKS ) {
+    snprintf(OutBuffer, InBufferSize, "%s", "");
+    return;
+  }
+  name = InIndex->bookNames[InRange->book];
+  if ( NULL == name ) {
+    name = "";
+  }
+
+  sc = InRange->startChapter;
+  sv = InRange->startVerse;
+  ec = InRange->endChapter;
+  ev = InRange->endVerse;
+
+  if ( 1 == sc && 1 == sv && SCRIPTURE_LAST_VERSE == ev &&
+       (SCRIPTURE_LAST_CHAPTER == ec || InIndex->chapterCounts[InRange->book] == ec) ) {
+    snprintf(OutBuffer, InBufferSize, "%s", name);
+  } else if ( 1 == sv && SCRIPTURE_LAST_VERSE == ev ) {
+    if ( sc == ec ) {
+      snprintf(OutBuffer, InBufferSize, "%s %d", name, sc);
+    } else {
+      snprintf(OutBuffer, InBufferSize, "%s %d-%d", name, sc, ec);
+    }
+  } else if ( sc == ec ) {
+    if ( sv == ev ) {
+      snprintf(OutBuffer, InBufferSize, "%s %d:%d", name, sc, sv);
+    } else {
+      snprintf(OutBuffer, InBufferSize, "%s %d:%d-%d", name, sc, sv, ev);
+    }
+  } else {
+    snprintf(OutBuffer, InBufferSize, "%s %d:%d-%d:%d", name, sc, sv, ec, ev);
+  }
+}
+
+/*****************************************************************************!
+ * Function : BookIndexNodeCreate
+ *****************************************************************************/
+static int
+BookIndexNodeCreate
+(BookIndex* InIndex)
+{
+  BookIndexNode*                        nodes;
+  BookIndexNode*                        node;
+
+  if ( InIndex->nodeCount == InIndex->nodeSize ) {
+    nodes = (BookIndexNode*)GetMemory(sizeof(BookIndexNode) * InIndex->nodeSize * 2);
+    memcpy(nodes, InIndex->nodes, sizeof(BookIndexNode) * InIndex->nodeCount);
+    FreeMemory(InIndex->nodes);
+    InIndex->nodes = nodes;
+    InIndex->nodeSize *= 2;
+  }
+  node = &InIndex->nodes[InIndex->nodeCount];
+  memset(node, 0x00, sizeof(BookIndexNode));
+  return InIndex->nodeCount++;
+}
+
+/*****************************************************************************!
+ * Function : BookIndexCharIndex
+ *****************************************************************************/
+static int
+BookIndexCharIndex
+(char InChar)
+{
+  if ( InChar >= 'a' && InChar <= 'z' ) {
+    return InChar - 'a';
+  }
+  if ( InChar >= 'A' && InChar <= 'Z' ) {
+    return InChar - 'A';
+  }
+  if ( InChar >= '0' && InChar <= '9' ) {
+    return 26 + InChar - '0';
+  }
+  return -1;
+}
+
+/*****************************************************************************!
+ * Function : BookIndexInsert
+ *  Insert InName, marking each node along the path with InBook when
+ *  InPrefix is set.  Returns the final node or -1 for an empty name.
+ *****************************************************************************/
+static int
+BookIndexInsert
+(BookIndex* InIndex, string InName, int InBook, bool InPrefix)
+{
+  int                                   node, child, c;
+  string                                s;
+  BookIndexNode*                        n;
+
+  node = 0;
+  for ( s = InName; *s; s++ ) {
+    c = BookIndexCharIndex(*s);
+    if ( c < 0 ) {
+      continue;
+    }
+    child = InIndex->nodes[node].children[c];
+    if ( 0 == child ) {
+      //! The node array may move, so index it again after growing
+      child = BookIndexNodeCreate(InIndex);
+      InIndex->nodes[node].children[c] = child;
+    }
+    node = child;
+    if ( InPrefix ) {
+      n = &InIndex->nodes[node];
+      if ( 0 == n->prefixBook ) {
+        n->prefixBook = InBook;
+      } else if ( n->prefixBook != InBook ) {
+        n->prefixBook = BOOK_INDEX_AMBIGUOUS;
+      }
+    }
+  }
+  if ( 0 == node ) {
+    return -1;
+  }
+  InIndex->nodes[node].exactBook = InBook;
+  return node;
+}
+
+/*****************************************************************************!
+ * Function : ReferenceIsBookStart
+ *  A book starts with a letter, or with a number followed by a letter
+ *  ("1 Cor", "2Kgs")
+ *****************************************************************************/
+static bool
+ReferenceIsBookStart
+(string InPosition)
+{
+  string                                s;
+
+  if ( isalpha((unsigned char)*InPosition) ) {
+    return true;
+  }
+  if ( ! isdigit((unsigned char)*InPosition) ) {
+    return false;
+  }
+  for ( s = InPosition; isdigit((unsigned char)*s); s++ ) {
+  }
+  while ( *s == ' ' || *s == '.' ) {
+    s++;
+  }
+  return isalpha((unsigned char)*s) ? true : false;
+}
+
+/*****************************************************************************!
+ * Function : ReferenceIsDash
+ *  Accept a hyphen or a UTF-8 en dash
+ *****************************************************************************/
+static bool
+ReferenceIsDash
+(string InPosition, int* OutLength)
+{
+  if ( *InPosition == '-' ) {
+    *OutLength = 1;
+    return true;
+  }
+  if ( (unsigned char)InPosition[0] == 0xE2 &&
+       (unsigned char)InPosition[1] == 0x80 &&
+       (unsigned char)InPosition[2] == 0x93 ) {
+    *OutLength = 3;
+    return true;
+  }
+  return false;
+}
+
+/*****************************************************************************!
+ * Function : ReferenceParseNumber
+ *  Returns -1 if there is no number at the position
+ *****************************************************************************/
+static int
+ReferenceParseNumber
+(string* InOutPosition)
+{
+  string                                s;
+  int                                   n;
+
+  s = *InOutPosition;
+  if ( ! isdigit((unsigned char)*s) ) {
+    return -1;
+  }
+  n = 0;
+  while ( isdigit((unsigned char)*s) ) {
+    if ( n <= SCRIPTURE_LAST_VERSE ) {
+      n = n * 10 + (*s - '0');
+    }
+    s++;
+  }
+  *InOutPosition = s;
+  return n;
+}
+
+/*****************************************************************************!
+ * Function : ReferenceSkipSpaces
+ *****************************************************************************/
+static string
+ReferenceSkipSpaces
+(string InPosition)
+{
+  while ( isspace((unsigned char)*InPosition) ) {
+    InPosition++;
+  }
+  return InPosition;
+}
@@ -0,0 +1,100 @@
+/*****************************************************************************
+ * FILE NAME    : ScriptureReference.h
+ * DATE         : October 19 2026
+ * PROJECT      :
+ * COPYRIGHT    : Copyright (C) 2026 by Gregory R Saltis
+ *****************************************************************************/
+#ifndef _scripturereference_h_
+#define _scripturereference_h_
+
+/*****************************************************************************!
+ * Global Headers
+ *****************************************************************************/
+#include <stdbool.h>
+
+/*****************************************************************************!
+ * Local Headers
+ *****************************************************************************/
+#include "GeneralUtilities/StringUtil.h"
+
+/*****************************************************************************!
+ * Exported Macros
+ *****************************************************************************/
+#define BOOK_INDEX_MAX_BOOKS            256
+#define SCRIPTURE_LAST_CHAPTER          999
+#define SCRIPTURE_LAST_VERSE            999
+
+#define SCRIPTURE_REFERENCE_INVALID     -1
+#define SCRIPTURE_REFERENCE_TOO_MANY    -2
+
+/*****************************************************************************!
+ * Exported Type : BookIndex
+ *  In-memory index of book names and aliases.  Names are stored in a trie
+ *  keyed on their lower case letters and digits, so a lookup costs the
+ *  length of the name regardless of how many books there are.  Any
+ *  unambiguous prefix of a full book name resolves to that book.
+ *****************************************************************************/
+struct _BookIndexNode;
+
+struct _BookIndex
+{
+  struct _BookIndexNode*                nodes;
+  int                                   nodeCount;
+  int                                   nodeSize;
+  string                                bookNames[BOOK_INDEX_MAX_BOOKS];
+  int                                   chapterCounts[BOOK_INDEX_MAX_BOOKS];
+};
+typedef struct _BookIndex BookIndex;
+
+/*****************************************************************************!
+ * Exported Type : ScriptureRange
+ *  One resolved reference; ids are book * 1000000 + chapter * 1000 + verse
+ *****************************************************************************/
+struct _ScriptureRange
+{
+  int                                   book;
+  int                                   startChapter;
+  int                                   startVerse;
+  int                                   endChapter;
+  int                                   endVerse;
+  int                                   startID;
+  int                                   endID;
+};
+typedef struct _ScriptureRange ScriptureRange;
+
+/*****************************************************************************!
+ * Exported Functions
+ *****************************************************************************/
+BookIndex*
+BookIndexCreate
+();
+
+void
+BookIndexDestroy
+(BookIndex* InIndex);
+
+bool
+BookIndexAddBook
+(BookIndex* InIndex, string InName, int InBook, int InChapterCount);
+
+bool
+BookIndexAddAlias
+(BookIndex* InIndex, string InAlias, int InBook);
+
+void
+BookIndexAddStandardAliases
+(BookIndex* InIndex);
+
+int
+BookIndexLookup
+(BookIndex* InIndex, string InName, int InLength);
+
+int
+ScriptureReferenceParse
+(BookIndex* InIndex, string InReference, ScriptureRange* OutRanges, int InMaxRanges);
+
+void
+ScriptureRangeFormat
+(BookIndex* InIndex, ScriptureRange* InRange, string OutBuffer, int InBufferSize);
+
+#endif /* _scripturereference_h_ */
@@ -1 +1,4 @@
-main.o : main.c
+main.o : main.c OutputSink.h ScriptureReference.h ChapterSchedule.h
+ChapterSchedule.o : ChapterSchedule.c ChapterSchedule.h
+OutputSink.o : OutputSink.c OutputSink.h
+ScriptureReference.o : ScriptureReference.c ScriptureReference.h
@@ -21,6 +21,9 @@
 #include "GeneralUtilities/StringUtil.h"
 #include "RPIBaseModules/sqlite3.h"
 #include "GeneralUtilities/MemoryManager.h"
+#include "OutputSink.h"
+#include "ScriptureReference.h"
+#include "ChapterSchedule.h"
 
 /*****************************************************************************!
  * Local Macros
@@ -46,7 +49,14 @@
   "WHERE id >= %d AND id <= %d "                \
   "ORDER BY books.%s, c;"                       \
   
+#define BOOKS_QUERY_STRING                      \
+  "SELECT books.canonical, books.name, MAX(c) " \
+  "FROM t_%s "                                  \
+  "JOIN books ON b == books.canonical "         \
+  "GROUP BY books.canonical;"
+
 #define SECONDS_IN_DAY                  86400
+#define REFERENCE_MAX_RANGES            64
 
 /******************************************************************************!
  * Local Type : ChapterCount
@@ -107,6 +117,12 @@ mainReadToday = false;
 bool
 mainDisplayReadingSchedule = false;
 
+bool
+mainReadYear = false;
+
+bool
+mainChapterAligned = false;
+
 ReadScheduleEntry**
 mainReadingSchedule;
 
@@ -137,6 +153,21 @@ mainBibleVersion = NULL;
 string
 mainBibleVersionDefault = "asv";
 
+string
+mainOutputFormats = NULL;
+
+string
+mainOutputFormatsDefault = "html";
+
+string
+mainReferenceQuery = NULL;
+
+BookIndex*
+mainBookIndex = NULL;
+
+char
+mainBooksQueryString[1024];
+
 /*****************************************************************************!
  * Local Functions
  *****************************************************************************/
@@ -172,10 +203,38 @@ void
 DisplayHelp
 ();
 
-void
+bool
 ReadTodaysVerses
 ();
 
+bool
+ReadYearsVerses
+();
+
+bool
+ReadScheduleDay
+(OutputSink* InSinks, int InDay, time_t InDate);
+
+bool
+ReadVerseRange
+(OutputSink* InSinks, int InStartID, int InEndID, string InTitle);
+
+OutputSink*
+CreateOutputSinks
+(string InBaseName);
+
+BookIndex*
+CreateBookIndex
+();
+
+bool
+ReadReferenceVerses
+(string InReference);
+
+bool
+CreateChapterAlignedCounts
+();
+
 ReadScheduleEntry*
 ReadScheduleEntryCreate
 (string InStartBook, int InStartBookIndex, int InStartChapter, int InStartVerse, string InEndBook, int InEndBookIndex, int InEndChapter, int InEndVerse);
@@ -215,6 +274,10 @@ int main(int argc, char** argv)
     return EXIT_FAILURE;
   }
 
+  if ( mainReferenceQuery ) {
+    return ReadReferenceVerses(mainReferenceQuery) ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
   mainRemainingDays = GetNumberofDaysRemaining();
   totalVerses = GetTotalVersesCount();
   mainReadingSchedule = (ReadScheduleEntry**)GetMemory(mainRemainingDays * sizeof(ReadScheduleEntry*));
@@ -226,25 +289,34 @@ int main(int argc, char** argv)
   mainDailyVerseCount = (int*)GetMemory(sizeof(int) * mainRemainingDays);
 
 
-  k = 0;
-  for ( j = 0; j < mainRemainingDays; j++) {
-    f = totalVersesRead + versePerDay;
-    i = (int)f - totalVersesReadI;
-    totalVersesReadI += i;
-    totalVersesRead += versePerDay;
-    if ( j + 1 < mainRemainingDays ) {
-      k += i;
-    }
-    mainDailyVerseCount[j] = i;
+  if ( mainChapterAligned && ! CreateChapterAlignedCounts() ) {
+    fprintf(stderr, "Cannot split the chapters into %d days, splitting by verse\n", mainRemainingDays);
+    mainChapterAligned = false;
   }
 
-  mainDailyVerseCount[mainRemainingDays-1] = totalVerses - k;
+  if ( ! mainChapterAligned ) {
+    k = 0;
+    for ( j = 0; j < mainRemainingDays; j++) {
+      f = totalVersesRead + versePerDay;
+      i = (int)f - totalVersesReadI;
+      totalVersesReadI += i;
+      totalVersesRead += versePerDay;
+      if ( j + 1 < mainRemainingDays ) {
+        k += i;
+      }
+      mainDailyVerseCount[j] = i;
+    }
+
+    mainDailyVerseCount[mainRemainingDays-1] = totalVerses - k;
+  }
   CreateReadingSchedule();
 
   if ( mainDisplayReadingSchedule ) {
     DisplayReadingSchdule();
+  } else if ( mainReadYear ) {
+    return ReadYearsVerses() ? EXIT_SUCCESS : EXIT_FAILURE;
   } else if ( mainReadToday ) {
-    ReadTodaysVerses();
+    return ReadTodaysVerses() ? EXIT_SUCCESS : EXIT_FAILURE;
   }
   return EXIT_SUCCESS;
 }
@@ -299,6 +371,39 @@ GetTotalVersesCount()
   return totalVerses;
 }
 
+/******************************************************************************!
+ * Function : CreateChapterAlignedCounts
+ *  Fill mainDailyVerseCount with whole chapters per day, keeping the daily
+ *  verse counts as even as possible
+ ******************************************************************************/
+bool
+CreateChapterAlignedCounts
+()
+{
+  ChapterCount*                         chapter;
+  int*                                  verses;
+  int                                   n;
+  bool                                  result;
+
+  n = 0;
+  for ( chapter = mainBibleChapters; chapter; chapter = chapter->next ) {
+    n++;
+  }
+  if ( 0 == n ) {
+    return false;
+  }
+
+  verses = (int*)GetMemory(sizeof(int) * n);
+  n = 0;
+  for ( chapter = mainBibleChapters; chapter; chapter = chapter->next ) {
+    verses[n++] = chapter->verseCount;
+  }
+
+  result = ChapterScheduleCreate(verses, n, mainRemainingDays, mainDailyVerseCount);
+  FreeMemory(verses);
+  return result;
+}
+
 /******************************************************************************!
  * Function : GetNumberofDaysRemaining();
  ******************************************************************************/
@@ -481,10 +586,14 @@ Initialize
 {
   mainBibleVersion = StringCopy(mainBibleVersionDefault);
   mainBookSortOrder = StringCopy(mainBookSortOrderDefault);
+  mainOutputFormats = StringCopy(mainOutputFormatsDefault);
   mainReadToday = false;
+  mainReadYear = false;
+  mainChapterAligned = false;
   mainDisplayReadingSchedule = false;
   mainUserStartDate = NULL;
   mainUserReadingDate = NULL;
+  mainReferenceQuery = NULL;
 }
 
 /******************************************************************************!
@@ -545,8 +654,40 @@ ProcessCommandLine
       mainUserReadingDate = StringCopy(argv[i]);
       continue;
     }
+
+    if ( StringEqualsOneOf(command, "-o", "--output", NULL ) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s requires a format list\n", command);
+        DisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      if ( mainOutputFormats ) {
+        FreeMemory(mainOutputFormats);
+      }
+      mainOutputFormats = StringCopy(argv[i]);
+      continue;
+    }
+
+    if ( StringEqualsOneOf(command, "-f", "--find", NULL ) ) {
+      i++;
+      if ( i == argc ) {
+        fprintf(stderr, "%s requires a reference\n", command);
+        DisplayHelp();
+        exit(EXIT_FAILURE);
+      }
+      if ( mainReferenceQuery ) {
+        FreeMemory(mainReferenceQuery);
+      }
+      mainReferenceQuery = StringCopy(argv[i]);
+      continue;
+    }
     if ( StringEqual(command, "-r") || StringEqual(command, "--read" ) ) {
       mainReadToday = true;
+    } else if ( StringEqual(command, "-y") || StringEqual(command, "--year" ) ) {
+      mainReadYear = true;
+    } else if ( StringEqual(command, "-c") || StringEqual(command, "--chapters" ) ) {
+      mainChapterAligned = true;
     } else if ( StringEqual(command, "-h") || StringEqual(command, "--help") ) {
       DisplayHelp();
       exit(EXIT_SUCCESS);
@@ -595,33 +736,99 @@ DisplayHelp
   fprintf(stdout, "%*s-d, --date MM/DD/YYYY      : Define the date for which the scripture is to be read\n", n, " ");
   fprintf(stdout, "%*s-h, --help                 : Display this information\n", n, " ");
   fprintf(stdout, "%*s-r, --read                 : Read today's scripture\n", n, " ");
+  fprintf(stdout, "%*s-y, --year                 : Read the whole schedule into year.*\n", n, " ");
+  fprintf(stdout, "%*s-f, --find REFERENCE       : Read a reference such as \"Gen 1:1-3; Ps 23\" into passage.*\n", n, " ");
+  fprintf(stdout, "%*s-o, --output html,txt,epub : Output formats written in one pass (default html)\n", n, " ");
   fprintf(stdout, "%*s-s, --sort can chron       : Sort in either canonical or chronological order (default chronological\n", n, " ");
   fprintf(stdout, "%*s-b, --bibleversion         : Bible version (default asv)\n", n, " ");
   fprintf(stdout, "%*s-s, --schedule             : Read reading schedule\n", n, " ");
+  fprintf(stdout, "%*s-c, --chapters             : Only end a day's reading at the end of a chapter\n", n, " ");
 }
 
 /******************************************************************************!
  * Function : ReadTodaysVerses
  ******************************************************************************/
-void
+bool
 ReadTodaysVerses
 ()
 {
   time_t                                startDate, todaysDate;
   int                                   elapsedDays;
-  ReadScheduleEntry*                    entry;
-  int                                   startid, endid;
-  sqlite3_stmt*                         statement;
-  string                                bookName, text;
-  int                                   chapter, verse;
-  FILE*                                 outFile;
-  struct tm*                            d;
+  OutputSink*                           sinks;
+  bool                                  result;
   
   todaysDate = GetReadingDate();
   startDate = GetStartDate();
 
   elapsedDays = GetElapsedDays(startDate, todaysDate);
-  entry = mainReadingSchedule[elapsedDays];
+  if ( elapsedDays >= mainRemainingDays ) {
+    fprintf(stderr, "The reading date is past the end of the schedule\n");
+    return false;
+  }
+
+  sinks = CreateOutputSinks("today");
+  if ( NULL == sinks ) {
+    return false;
+  }
+  ReadScheduleDay(sinks, elapsedDays, todaysDate);
+  result = ! OutputSinkListFailed(sinks);
+  if ( result ) {
+    OutputSinkListEnd(sinks);
+  } else {
+    OutputSinkListAbort(sinks);
+  }
+  OutputSinkListDestroy(sinks);
+  return result;
+}
+
+/******************************************************************************!
+ * Function : ReadYearsVerses
+ *  Write every day of the reading schedule, each as its own section
+ ******************************************************************************/
+bool
+ReadYearsVerses
+()
+{
+  time_t                                startDate;
+  int                                   i;
+  OutputSink*                           sinks;
+  bool                                  result;
+
+  startDate = GetStartDate();
+  sinks = CreateOutputSinks("year");
+  if ( NULL == sinks ) {
+    return false;
+  }
+  result = true;
+  for ( i = 0; i < mainRemainingDays && result; i++ ) {
+    ReadScheduleDay(sinks, i, startDate + (time_t)i * SECONDS_IN_DAY);
+    result = ! OutputSinkListFailed(sinks);
+  }
+  if ( result ) {
+    OutputSinkListEnd(sinks);
+  } else {
+    OutputSinkListAbort(sinks);
+  }
+  OutputSinkListDestroy(sinks);
+  return result;
+}
+
+/******************************************************************************!
+ * Function : ReadScheduleDay
+ ******************************************************************************/
+bool
+ReadScheduleDay
+(OutputSink* InSinks, int InDay, time_t InDate)
+{
+  ReadScheduleEntry*                    entry;
+  int                                   startid, endid;
+  struct tm*                            d;
+  char                                  title[64];
+
+  entry = mainReadingSchedule[InDay];
+  if ( NULL == entry ) {
+    return false;
+  }
   startid =
     entry->startBookIndex * 1000000 +
     entry->startChapter * 1000 +
@@ -632,42 +839,178 @@ ReadTodaysVerses
     entry->endChapter * 1000 +
     entry->endVerse;
 
-  sprintf(mainVersesQueryRange, VERSE_QUERY_RANGE, mainBibleVersion, startid, endid, mainBookSortOrder);
+  d = localtime(&InDate);
+  sprintf(title, "%s %d %d", mainMonthNames[d->tm_mon], d->tm_mday, 1900 + d->tm_year);
+  return ReadVerseRange(InSinks, startid, endid, title);
+}
+
+/******************************************************************************!
+ * Function : ReadVerseRange
+ *  Read the verses InStartID..InEndID once and fan each row out to every
+ *  sink in InSinks
+ ******************************************************************************/
+bool
+ReadVerseRange
+(OutputSink* InSinks, int InStartID, int InEndID, string InTitle)
+{
+  sqlite3_stmt*                         statement;
+  string                                bookName, text;
+  int                                   chapter, verse;
+
+  sprintf(mainVersesQueryRange, VERSE_QUERY_RANGE, mainBibleVersion, InStartID, InEndID, mainBookSortOrder);
   if ( SQLITE_OK != sqlite3_prepare_v2(mainDatabase, mainVersesQueryRange, strlen(mainVersesQueryRange), &statement, NULL) ) {
-    return;
+    return false;
   }
 
   if ( SQLITE_ROW != sqlite3_step(statement) ) {
     sqlite3_finalize(statement);
-    return ;
-  }
-
-  d = localtime(&todaysDate);
-  outFile = fopen("today.html", "wb");
-  fprintf(outFile, "<HTML>\n");
-  fprintf(outFile, "<HEAD>\n");
-  fprintf(outFile, "  <LINK href=\"style.css\" type=\"text/css\" rel=\"stylesheet\"></LINK>\n");
-  fprintf(outFile, "</HEAD>\n");
-  fprintf(outFile, "<BODY>\n");
-  fprintf(outFile, "  <A class=\"DateDisplay\">");
-  fprintf(outFile, "%s %d %d</A>\n", mainMonthNames[d->tm_mon], d->tm_mday, 1900 + d->tm_year);
-  fprintf(outFile, "<TABLE>\n");
+    return false;
+  }
+
+  //! The sinks open their files here, so an empty range writes nothing
+  if ( ! OutputSinkListBeginSection(InSinks, InTitle) ) {
+    sqlite3_finalize(statement);
+    return false;
+  }
   do {
     bookName = (string)sqlite3_column_text(statement, 0);
     chapter  = sqlite3_column_int(statement, 1);
     verse = sqlite3_column_int(statement, 2);
     text = (string)sqlite3_column_text(statement, 4);
-    fprintf(outFile, "<tr>\n");
-    fprintf(outFile, "<td class=\"verse\">%s %d:%d</td>\n", bookName, chapter, verse);
-    fprintf(outFile, "<td class=\"text\">%s</td>\n", text);
-    fprintf(outFile, "</tr>\n");
+    OutputSinkListWriteVerse(InSinks, bookName, chapter, verse, text);
   }  
   while ( SQLITE_ROW == sqlite3_step(statement) );    
-  fprintf(outFile, "</TABLE>\n");
-  fprintf(outFile, "</BODY>\n");
-  fprintf(outFile, "</HTML>\n");
-  fclose(outFile);
+  OutputSinkListEndSection(InSinks);
+  sqlite3_finalize(statement);
+  return true;
+}
+
+/******************************************************************************!
+ * Function : CreateOutputSinks
+ *  Create one sink for each format named in mainOutputFormats
+ ******************************************************************************/
+OutputSink*
+CreateOutputSinks
+(string InBaseName)
+{
+  StringList*                           formats;
+  OutputSink*                           sinks = NULL;
+  OutputSink*                           sink;
+  OutputSink*                           other;
+  int                                   i;
+
+  formats = StringSplit(mainOutputFormats, ",", false);
+  if ( NULL == formats ) {
+    return NULL;
+  }
+
+  for ( i = 0; i < formats->stringCount; i++ ) {
+    sink = OutputSinkCreate(formats->strings[i], InBaseName);
+    if ( NULL == sink ) {
+      fprintf(stderr, "Unknown output format %s\n", formats->strings[i]);
+      continue;
+    }
+
+    //! Aliases such as txt and text share a file name; keep only the first
+    for ( other = sinks; other; other = other->next ) {
+      if ( StringEqual(other->fileName, sink->fileName) ) {
+        break;
+      }
+    }
+    if ( other ) {
+      OutputSinkDestroy(sink);
+      continue;
+    }
+    sinks = OutputSinkListAppend(sinks, sink);
+  }
+  StringListDestroy(formats);
+  if ( NULL == sinks ) {
+    fprintf(stderr, "No usable output format in %s\n", mainOutputFormats);
+  }
+  return sinks;
+}
+
+/******************************************************************************!
+ * Function : CreateBookIndex
+ *  Load the book names once so references resolve without a query each
+ ******************************************************************************/
+BookIndex*
+CreateBookIndex
+()
+{
+  BookIndex*                            index;
+  sqlite3_stmt*                         statement;
+
+  sprintf(mainBooksQueryString, BOOKS_QUERY_STRING, mainBibleVersion);
+  if ( SQLITE_OK != sqlite3_prepare_v2(mainDatabase, mainBooksQueryString, strlen(mainBooksQueryString), &statement, NULL) ) {
+    return NULL;
+  }
+
+  index = BookIndexCreate();
+  while ( SQLITE_ROW == sqlite3_step(statement) ) {
+    BookIndexAddBook(index,
+                     (string)sqlite3_column_text(statement, 1),
+                     sqlite3_column_int(statement, 0),
+                     sqlite3_column_int(statement, 2));
+  }
   sqlite3_finalize(statement);
+  BookIndexAddStandardAliases(index);
+  return index;
+}
+
+/******************************************************************************!
+ * Function : ReadReferenceVerses
+ *  Resolve InReference against the book index and write each range as its
+ *  own section to passage.*
+ ******************************************************************************/
+bool
+ReadReferenceVerses
+(string InReference)
+{
+  ScriptureRange                        ranges[REFERENCE_MAX_RANGES];
+  int                                   i, n;
+  bool                                  result;
+  OutputSink*                           sinks;
+  char                                  title[128];
+
+  if ( NULL == mainBookIndex ) {
+    mainBookIndex = CreateBookIndex();
+    if ( NULL == mainBookIndex ) {
+      return false;
+    }
+  }
+
+  n = ScriptureReferenceParse(mainBookIndex, InReference, ranges, REFERENCE_MAX_RANGES);
+  if ( SCRIPTURE_REFERENCE_TOO_MANY == n ) {
+    fprintf(stderr, "Too many ranges in %s (at most %d)\n", InReference, REFERENCE_MAX_RANGES);
+    return false;
+  }
+  if ( n <= 0 ) {
+    fprintf(stderr, "Invalid reference %s\n", InReference);
+    return false;
+  }
+
+  sinks = CreateOutputSinks("passage");
+  if ( NULL == sinks ) {
+    return false;
+  }
+  result = true;
+  for ( i = 0; i < n; i++ ) {
+    ScriptureRangeFormat(mainBookIndex, &ranges[i], title, sizeof(title));
+    if ( ReadVerseRange(sinks, ranges[i].startID, ranges[i].endID, title) ) {
+      continue;
+    }
+    if ( OutputSinkListFailed(sinks) ) {
+      OutputSinkListAbort(sinks);
+      OutputSinkListDestroy(sinks);
+      return false;
+    }
+    fprintf(stderr, "No verses found for %s\n", title);
+    result = false;
+  }
+  OutputSinkListEnd(sinks);
+  OutputSinkListDestroy(sinks);
+  return result;
 }
 
 /******************************************************************************!